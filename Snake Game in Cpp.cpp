@@ -4,81 +4,119 @@
 */
 
 #include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <cmath>
+#include <cstdlib>
 #include <raylib.h>
 #include <deque>
+#include <vector>
 #include <raymath.h>
 
 using namespace std;
 
 // Global variables for game settings and states
-static bool allowMove = false;       // Controls if the snake can move in the current frame
 Color green = { 173, 204, 96, 255 }; // Background color
 Color darkGreen = { 43, 51, 24, 255 }; // Snake and border color
 
 int cellSize = 30;                  // Size of each grid cell
-int cellCount = 25;                 // Number of cells along each dimension of the grid
-int offset = 75;                    // Offset for the grid from the window edges
+int offset = 75;                    // Offset for the grids from the window edges and from each other
 
+const int DEFAULT_CELL_COUNT = 25;     // Number of cells along each dimension of the grid
+const int MAX_SESSIONS = 4;            // Most games that can run side by side in the window
 const double SPEED_UP_INTERVAL = 10.0; // Time interval for increasing game speed (in seconds)
 const float SPEED_MULTIPLIER = 0.9f;   // Factor by which game speed increases
+const float INITIAL_GAME_SPEED = 0.2f; // Initial speed of the game (lower is faster)
+const unsigned int MAX_QUEUED_TURNS = 3; // Number of key presses buffered ahead of the snake
+const int MAX_RANDOM_FOOD_TRIES = 64;  // Random picks before food placement falls back to scanning free cells
+const int MAX_SCENARIO_BOARD = 40;     // Largest board a scenario may request, keeping the window usable
 
-float gameSpeed = 0.2f;                // Initial speed of the game (lower is faster)
-double lastSpeedUpTime = 0;           // Tracks the last time speed was increased
-
-double lastUpdateTime = 0;           // Tracks the last time the game logic was updated
-
-// Function to check if a given element exists in a deque
-bool ElementInDeque(Vector2 element, deque<Vector2> deque)
+// Function to check if a specific time interval has elapsed since lastTime
+bool EventTriggered(double interval, double& lastTime)
 {
-    for (unsigned int i = 0; i < deque.size(); i++)
+    double currentTime = GetTime(); // Get the current time in seconds
+    if (currentTime - lastTime >= interval)
     {
-        if (Vector2Equals(deque[i], element))
-        {
-            return true;
-        }
+        lastTime = currentTime; // Update the last update time
+        return true;
     }
     return false;
 }
 
-// Function to check if a specific time interval has elapsed
-bool EventTriggered(double interval)
+// Assets class to load textures and sounds once and share them between games
+class Assets
 {
-    double currentTime = GetTime(); // Get the current time in seconds
-    if (currentTime - lastUpdateTime >= interval)
+public:
+    Texture2D foodTexture;          // Texture for rendering the food
+    Sound eatSound;                 // Sound effect for eating food
+    Sound wallSound;                // Sound effect for collisions with walls
+
+    Assets()
     {
-        lastUpdateTime = currentTime; // Update the last update time
-        return true;
+        Image image = LoadImage("Graphics/food.png");
+        foodTexture = LoadTextureFromImage(image);
+        UnloadImage(image);
+        eatSound = LoadSound("Sounds/eat.mp3");
+        wallSound = LoadSound("Sounds/wall.mp3");
     }
-    return false;
-}
 
-// Function to gradually increase the game speed
-void SpeedUpGame()
-{
-    double currentTime = GetTime(); // Get the current time
-    if (currentTime - lastSpeedUpTime >= SPEED_UP_INTERVAL)
+    // Copies would unload the shared resources twice
+    Assets(const Assets&) = delete;
+    Assets& operator=(const Assets&) = delete;
+
+    ~Assets()
     {
-        gameSpeed *= SPEED_MULTIPLIER; // Increase the game speed
-        lastSpeedUpTime = currentTime; // Update the last speed-up time
+        UnloadTexture(foodTexture);
+        UnloadSound(eatSound);
+        UnloadSound(wallSound);
     }
-}
+};
+
+// Events emitted by the game logic and handled after the update
+enum GameEvent
+{
+    EVENT_FOOD_EATEN,
+    EVENT_GAME_OVER
+};
 
 // Snake class to handle the snake's behavior and state
 class Snake
 {
 public:
-    deque<Vector2> body = { Vector2{6, 9}, Vector2{5, 9}, Vector2{4, 9} }; // Initial snake body
-    Vector2 direction = { 1, 0 }; // Initial direction of movement
+    deque<Vector2> startBody = { Vector2{6, 9}, Vector2{5, 9}, Vector2{4, 9} }; // Body restored on reset
+    Vector2 startDirection = { 1, 0 }; // Direction restored on reset
+    deque<Vector2> body;         // Current snake body, head first
+    Vector2 direction;           // Current direction of movement
     bool addSegment = false;     // Whether to add a new segment to the snake
+    int cellCount;               // Number of cells along each dimension of this snake's grid
+    vector<unsigned char> occupancy; // Number of segments in each grid cell, stored row-major
 
-    // Draws the snake on the screen
-    void Draw()
+    Snake(int cellCount) : cellCount(cellCount)
+    {
+        Reset();
+    }
+
+    // Checks if a cell lies inside the grid
+    bool InBounds(Vector2 cell) const
+    {
+        return cell.x >= 0 && cell.x < cellCount && cell.y >= 0 && cell.y < cellCount;
+    }
+
+    // Returns how many segments currently cover a cell (cells outside the grid are always empty)
+    int SegmentsAt(Vector2 cell) const
+    {
+        return InBounds(cell) ? occupancy[(int)cell.y * cellCount + (int)cell.x] : 0;
+    }
+
+    // Draws the snake on the screen, with the grid's top-left corner at origin
+    void Draw(Vector2 origin)
     {
         for (unsigned int i = 0; i < body.size(); i++)
         {
             float x = body[i].x;
             float y = body[i].y;
-            Rectangle segment = Rectangle{ offset + x * cellSize, offset + y * cellSize, (float)cellSize, (float)cellSize };
+            Rectangle segment = Rectangle{ origin.x + x * cellSize, origin.y + y * cellSize, (float)cellSize, (float)cellSize };
             DrawRectangleRounded(segment, 0.5, 6, darkGreen);
         }
     }
@@ -87,8 +125,10 @@ public:
     void Update()
     {
         body.push_front(Vector2Add(body[0], direction)); // Add a new head in the direction of movement
+        MarkCell(body[0], 1);
         if (!addSegment)
         {
+            MarkCell(body.back(), -1);
             body.pop_back(); // Remove the tail segment if no new segment is to be added
         }
         else
@@ -100,8 +140,23 @@ public:
     // Resets the snake to its initial state
     void Reset()
     {
-        body = { Vector2{6, 9}, Vector2{5, 9}, Vector2{4, 9} };
-        direction = { 1, 0 };
+        body = startBody;
+        direction = startDirection;
+        occupancy.assign(cellCount * cellCount, 0);
+        for (unsigned int i = 0; i < body.size(); i++)
+        {
+            MarkCell(body[i], 1);
+        }
+    }
+
+private:
+    // Adjusts the segment count of a cell, ignoring cells outside the grid
+    void MarkCell(Vector2 cell, int delta)
+    {
+        if (InBounds(cell))
+        {
+            occupancy[(int)cell.y * cellCount + (int)cell.x] += delta;
+        }
     }
 };
 
@@ -110,44 +165,256 @@ class Food
 {
 public:
     Vector2 position;         // Current position of the food
-    Texture2D texture;        // Texture for rendering the food
+    bool onBoard = true;      // Whether there is food at all (false once the snake fills the board)
+    const Texture2D& texture; // Shared texture for rendering the food
 
-    Food(deque<Vector2> snakeBody)
+    Food(const Snake& snake, const Texture2D& texture) : texture(texture)
     {
-        Image image = LoadImage("Graphics/food.png");
-        texture = LoadTextureFromImage(image);
-        UnloadImage(image);
-        position = GenerateRandomPos(snakeBody); // Generate initial food position
+        Respawn(snake); // Generate initial food position
     }
 
-    ~Food()
+    // Moves the food to a free cell, or removes it when the snake covers the whole board
+    void Respawn(const Snake& snake)
     {
-        UnloadTexture(texture);
+        onBoard = GenerateRandomPos(snake, position);
     }
 
-    // Draws the food on the screen
-    void Draw()
+    // Draws the food on the screen, with the grid's top-left corner at origin
+    void Draw(Vector2 origin)
     {
-        DrawTexture(texture, offset + position.x * cellSize, offset + position.y * cellSize, WHITE);
+        if (!onBoard)
+        {
+            return;
+        }
+        if (texture.id == 0)
+        {
+            // Texture failed to load, draw a placeholder in the food's cell instead
+            Rectangle cell = Rectangle{ origin.x + position.x * cellSize, origin.y + position.y * cellSize, (float)cellSize, (float)cellSize };
+            DrawRectangleRounded(cell, 0.5, 6, RED);
+            return;
+        }
+        DrawTexture(texture, origin.x + position.x * cellSize, origin.y + position.y * cellSize, WHITE);
     }
 
-    // Generates a random position within the grid
-    Vector2 GenerateRandomCell()
+    // Generates a random position within a grid of cellCount cells per side
+    Vector2 GenerateRandomCell(int cellCount)
     {
         float x = GetRandomValue(0, cellCount - 1);
         float y = GetRandomValue(0, cellCount - 1);
         return Vector2{ x, y };
     }
 
-    // Ensures the food position does not overlap with the snake
-    Vector2 GenerateRandomPos(deque<Vector2> snakeBody)
+    // Picks a cell that does not overlap with the snake, returning false if there is none
+    bool GenerateRandomPos(const Snake& snake, Vector2& position)
+    {
+        for (int i = 0; i < MAX_RANDOM_FOOD_TRIES; i++)
+        {
+            position = GenerateRandomCell(snake.cellCount);
+            if (snake.SegmentsAt(position) == 0)
+            {
+                return true;
+            }
+        }
+
+        // The board is nearly full, so pick uniformly among the remaining free cells
+        vector<Vector2> freeCells;
+        for (int y = 0; y < snake.cellCount; y++)
+        {
+            for (int x = 0; x < snake.cellCount; x++)
+            {
+                Vector2 cell = Vector2{ (float)x, (float)y };
+                if (snake.SegmentsAt(cell) == 0)
+                {
+                    freeCells.push_back(cell);
+                }
+            }
+        }
+        if (freeCells.empty())
+        {
+            return false;
+        }
+        position = freeCells[GetRandomValue(0, (int)freeCells.size() - 1)];
+        return true;
+    }
+};
+
+// Direction change scripted by a scenario for a given update
+struct ScriptedInput
+{
+    long tick;                      // Number of updates after the scenario starts
+    Vector2 direction;              // Direction queued before that update
+};
+
+// Scenario class describing a custom starting setup loaded from a text file
+//
+// Each line holds a keyword followed by its values, '#' starts a comment:
+//   board 25          number of cells along each dimension (at most MAX_SCENARIO_BOARD)
+//   speed 0.2         seconds between updates
+//   seed 1234         random seed for food placement (unseeded if omitted)
+//   direction 1 0     initial direction of movement
+//   food 10 10        initial food cell (random if omitted)
+//   segment 6 9       snake segment, listed from head to tail
+//   input 12 0 -1     direction queued before update 12, in tick order
+class Scenario
+{
+public:
+    int cellCount = DEFAULT_CELL_COUNT; // Number of cells along each dimension of the grid
+    float gameSpeed = INITIAL_GAME_SPEED; // Seconds between updates
+    bool hasSeed = false;           // Whether a random seed was given
+    unsigned int seed = 0;          // Random seed for food placement
+    Vector2 direction = { 1, 0 };   // Initial direction of movement
+    bool hasFood = false;           // Whether the food position was given
+    Vector2 food = { 0, 0 };        // Initial food position
+    deque<Vector2> body;            // Initial snake body, head first
+    vector<ScriptedInput> inputs;   // Scripted direction changes, sorted by tick
+
+    // Reads a scenario file, printing the reason and returning false if it is invalid
+    bool Load(const char* path)
+    {
+        ifstream file(path);
+        if (!file)
+        {
+            cout << "Cannot open scenario " << path << endl;
+            return false;
+        }
+
+        string line;
+        int lineNumber = 0;
+        while (getline(file, line))
+        {
+            lineNumber++;
+            line = line.substr(0, line.find('#'));
+            istringstream values(line);
+            string keyword;
+            if (!(values >> keyword))
+            {
+                continue; // Blank or comment-only line
+            }
+
+            bool valid = true;
+            if (keyword == "board")
+            {
+                valid = (values >> cellCount) && cellCount > 0 && cellCount <= MAX_SCENARIO_BOARD;
+            }
+            else if (keyword == "speed")
+            {
+                valid = (values >> gameSpeed) && gameSpeed > 0;
+            }
+            else if (keyword == "seed")
+            {
+                valid = (bool)(values >> seed);
+                hasSeed = true;
+            }
+            else if (keyword == "direction")
+            {
+                valid = ReadDirection(values, direction);
+            }
+            else if (keyword == "food")
+            {
+                valid = ReadCell(values, food);
+                hasFood = true;
+            }
+            else if (keyword == "segment")
+            {
+                Vector2 segment;
+                valid = ReadCell(values, segment);
+                body.push_back(segment);
+            }
+            else if (keyword == "input")
+            {
+                ScriptedInput input;
+                valid = (values >> input.tick) && input.tick >= 0 && ReadDirection(values, input.direction)
+                    && (inputs.empty() || inputs.back().tick <= input.tick);
+                inputs.push_back(input);
+            }
+            else
+            {
+                valid = false;
+            }
+
+            if (!valid || !(values >> ws).eof())
+            {
+                cout << path << ":" << lineNumber << ": invalid line \"" << line << "\"" << endl;
+                return false;
+            }
+        }
+
+        return CheckLayout(path);
+    }
+
+private:
+    // Reads two whole-number coordinates
+    static bool ReadCell(istringstream& values, Vector2& cell)
     {
-        Vector2 position = GenerateRandomCell();
-        while (ElementInDeque(position, snakeBody))
+        int x, y;
+        if (!(values >> x >> y))
         {
-            position = GenerateRandomCell();
+            return false;
         }
-        return position;
+        cell = Vector2{ (float)x, (float)y };
+        return true;
+    }
+
+    // Reads one of the four unit directions
+    static bool ReadDirection(istringstream& values, Vector2& direction)
+    {
+        int x, y;
+        if (!(values >> x >> y) || abs(x) + abs(y) != 1)
+        {
+            return false;
+        }
+        direction = Vector2{ (float)x, (float)y };
+        return true;
+    }
+
+    // Checks if a cell lies inside the scenario's board
+    bool InBoard(Vector2 cell) const
+    {
+        return cell.x >= 0 && cell.x < cellCount && cell.y >= 0 && cell.y < cellCount;
+    }
+
+    // Checks that the snake is a connected chain on the board that can move, and the food is on a free cell
+    bool CheckLayout(const char* path) const
+    {
+        if (body.empty())
+        {
+            cout << path << ": scenario needs at least one segment" << endl;
+            return false;
+        }
+
+        vector<bool> covered(cellCount * cellCount, false);
+        for (unsigned int i = 0; i < body.size(); i++)
+        {
+            if (!InBoard(body[i]))
+            {
+                cout << path << ": segment " << i << " lies outside the board" << endl;
+                return false;
+            }
+            int index = (int)body[i].y * cellCount + (int)body[i].x;
+            if (covered[index])
+            {
+                cout << path << ": segment " << i << " repeats an earlier cell" << endl;
+                return false;
+            }
+            covered[index] = true;
+            if (i > 0 && fabsf(body[i].x - body[i - 1].x) + fabsf(body[i].y - body[i - 1].y) != 1)
+            {
+                cout << path << ": segment " << i << " is not next to segment " << i - 1 << endl;
+                return false;
+            }
+        }
+
+        if (body.size() > 1 && Vector2Equals(Vector2Add(body[0], direction), body[1]))
+        {
+            cout << path << ": direction points back into the snake" << endl;
+            return false;
+        }
+        if (hasFood && (!InBoard(food) || covered[(int)food.y * cellCount + (int)food.x]))
+        {
+            cout << path << ": food must lie on a free cell of the board" << endl;
+            return false;
+        }
+        return true;
     }
 };
 
@@ -155,40 +422,95 @@ public:
 class Game
 {
 public:
-    Snake snake = Snake();          // Snake instance
-    Food food = Food(snake.body);   // Food instance
+    const Assets& assets;           // Shared textures and sounds
+    int cellCount;                  // Number of cells along each dimension of the grid
+    Vector2 origin;                 // Screen position of the grid's top-left corner
+    Snake snake = Snake(cellCount); // Snake instance
+    Food food = Food(snake, assets.foodTexture); // Food instance
     bool running = true;            // Indicates if the game is running
     int score = 0;                  // Current score
-    Sound eatSound;                 // Sound effect for eating food
-    Sound wallSound;                // Sound effect for collisions with walls
+    float startSpeed = INITIAL_GAME_SPEED; // Speed restored on game over
+    bool hasStartFood = false;      // Whether game over puts the food back on a fixed cell
+    Vector2 startFood = { 0, 0 };   // Food cell restored on game over
+    bool hasStartSeed = false;      // Whether game over reseeds the food placement
+    unsigned int startSeed = 0;     // Random seed restored on game over
+    float gameSpeed = INITIAL_GAME_SPEED; // Seconds between updates (lower is faster)
+    double lastSpeedUpTime = 0;     // Tracks the last time speed was increased
+    double lastUpdateTime = 0;      // Tracks the last time the game logic was updated
+    vector<GameEvent> events;       // Events raised during the last update only, waiting to be handled
+    deque<Vector2> queuedTurns;     // Directions pressed but not yet applied, one per update
+    deque<ScriptedInput> scriptedInputs; // Scenario inputs not yet queued
+    long tickCount = 0;             // Updates since the game or scenario started
+
+    Game(const Assets& assets, int cellCount, Vector2 origin) : assets(assets), cellCount(cellCount), origin(origin)
+    {
+    }
 
-    Game()
+    // Starts the game from a scenario; game over restores its snake, food, seed and speed,
+    // while the scripted inputs run only once
+    void ApplyScenario(const Scenario& scenario)
     {
-        InitAudioDevice();          // Initialize the audio system
-        eatSound = LoadSound("Sounds/eat.mp3");
-        wallSound = LoadSound("Sounds/wall.mp3");
+        snake.startBody = scenario.body;
+        snake.startDirection = scenario.direction;
+        hasStartFood = scenario.hasFood;
+        startFood = scenario.food;
+        hasStartSeed = scenario.hasSeed;
+        startSeed = scenario.seed;
+        startSpeed = scenario.gameSpeed;
+        scriptedInputs.assign(scenario.inputs.begin(), scenario.inputs.end());
+        tickCount = 0;
+        Restart();
     }
 
-    ~Game()
+    // Puts the snake, food and speed back to their starting state
+    void Restart()
     {
-        UnloadSound(eatSound);
-        UnloadSound(wallSound);
-        CloseAudioDevice();         // Close the audio system
+        snake.Reset();
+        queuedTurns.clear();
+        if (hasStartSeed)
+        {
+            SetRandomSeed(startSeed); // Makes every later food placement reproducible
+        }
+        if (hasStartFood)
+        {
+            food.position = startFood;
+            food.onBoard = true;
+        }
+        else
+        {
+            food.Respawn(snake);
+        }
+        gameSpeed = startSpeed;
     }
 
     // Draws the game elements on the screen
     void Draw()
     {
-        food.Draw();
-        snake.Draw();
-        DrawText(TextFormat("Score: %i", score), offset, offset - 40, 20, darkGreen);
+        float boardSize = (float)cellSize * cellCount;
+        DrawRectangleLinesEx(Rectangle{ origin.x - 5, origin.y - 5, boardSize + 10, boardSize + 10 }, 5, darkGreen);
+        food.Draw(origin);
+        snake.Draw(origin);
+        DrawText(TextFormat("Score: %i", score), origin.x, origin.y - 40, 20, darkGreen);
     }
 
     // Updates the game logic
     void Update()
     {
+        events.clear(); // Drop events nobody handled so the list never grows without a consumer
+        while (!scriptedInputs.empty() && scriptedInputs.front().tick <= tickCount)
+        {
+            QueueTurn(scriptedInputs.front().direction); // Scripted turns follow the same rules as key presses
+            scriptedInputs.pop_front();
+        }
+        tickCount++;
+
         if (running)
         {
+            if (!queuedTurns.empty())
+            {
+                snake.direction = queuedTurns.front(); // Apply one buffered turn per update
+                queuedTurns.pop_front();
+            }
             snake.Update();
             CheckCollisionWithFood();
             CheckCollisionWithEdges();
@@ -197,15 +519,59 @@ public:
         SpeedUpGame(); // Adjust game speed over time
     }
 
+    // Buffers a direction change, rejecting turns back into the snake's own neck
+    void QueueTurn(Vector2 turn)
+    {
+        Vector2 last = queuedTurns.empty() ? snake.direction : queuedTurns.back();
+        if (last.x == -turn.x && last.y == -turn.y)
+        {
+            return;
+        }
+        running = true;
+        if (!Vector2Equals(last, turn) && queuedTurns.size() < MAX_QUEUED_TURNS)
+        {
+            queuedTurns.push_back(turn);
+        }
+    }
+
+    // Gradually increases the game speed
+    void SpeedUpGame()
+    {
+        double currentTime = GetTime(); // Get the current time
+        if (currentTime - lastSpeedUpTime >= SPEED_UP_INTERVAL)
+        {
+            gameSpeed *= SPEED_MULTIPLIER; // Increase the game speed
+            lastSpeedUpTime = currentTime; // Update the last speed-up time
+        }
+    }
+
+    // Plays the side effects of the events raised since the last call
+    void HandleEvents()
+    {
+        for (unsigned int i = 0; i < events.size(); i++)
+        {
+            switch (events[i])
+            {
+            case EVENT_FOOD_EATEN:
+                PlaySound(assets.eatSound);
+                break;
+            case EVENT_GAME_OVER:
+                PlaySound(assets.wallSound);
+                break;
+            }
+        }
+        events.clear();
+    }
+
     // Checks if the snake has eaten the food
     void CheckCollisionWithFood()
     {
-        if (Vector2Equals(snake.body[0], food.position))
+        if (food.onBoard && Vector2Equals(snake.body[0], food.position))
         {
-            food.position = food.GenerateRandomPos(snake.body);
+            food.Respawn(snake);
             snake.addSegment = true;
             score++;
-            PlaySound(eatSound);
+            events.push_back(EVENT_FOOD_EATEN);
         }
     }
 
@@ -221,79 +587,131 @@ public:
     // Resets the game when the snake collides with itself or a wall
     void GameOver()
     {
-        snake.Reset();
-        food.position = food.GenerateRandomPos(snake.body);
+        Restart();
         running = false;
         score = 0;
-        gameSpeed = 0.2f; // Reset speed
         lastSpeedUpTime = GetTime();
-        PlaySound(wallSound);
+        events.push_back(EVENT_GAME_OVER);
     }
 
     // Checks for collisions between the snake's head and its body
     void CheckCollisionWithTail()
     {
-        deque<Vector2> headlessBody = snake.body;
-        headlessBody.pop_front();
-        if (ElementInDeque(snake.body[0], headlessBody))
+        if (snake.SegmentsAt(snake.body[0]) > 1) // The head's cell is also covered by another segment
         {
             GameOver();
         }
     }
 };
 
-int main()
+int main(int argc, char* argv[])
 {
-    cout << "Starting the game..." << endl;
-    InitWindow(2 * offset + cellSize * cellCount, 2 * offset + cellSize * cellCount, "Retro Snake");
-    SetTargetFPS(60);
-
-    Game game = Game();
-
-    while (!WindowShouldClose())
+    // Optional arguments: "--sessions N" runs N games side by side, a file path loads a scenario
+    Scenario scenario;
+    bool hasScenario = false;
+    int sessionCount = 1;
+    for (int i = 1; i < argc; i++)
     {
-        BeginDrawing();
-
-        if (EventTriggered(gameSpeed))
+        if (string(argv[i]) == "--sessions" && i + 1 < argc)
         {
-            allowMove = true;
-            game.Update();
+            sessionCount = atoi(argv[++i]);
+            if (sessionCount < 1 || sessionCount > MAX_SESSIONS)
+            {
+                cout << "Sessions must be between 1 and " << MAX_SESSIONS << endl;
+                return 1;
+            }
         }
-
-        // Handle user input for snake direction
-        if (IsKeyPressed(KEY_UP) && game.snake.direction.y != 1 && allowMove)
+        else if (!hasScenario)
         {
-            game.snake.direction = { 0, -1 };
-            game.running = true;
-            allowMove = false;
+            if (!scenario.Load(argv[i]))
+            {
+                return 1;
+            }
+            hasScenario = true;
         }
-        if (IsKeyPressed(KEY_DOWN) && game.snake.direction.y != -1 && allowMove)
+        else
         {
-            game.snake.direction = { 0, 1 };
-            game.running = true;
-            allowMove = false;
+            cout << "Usage: " << argv[0] << " [--sessions N] [scenario]" << endl;
+            return 1;
         }
-        if (IsKeyPressed(KEY_LEFT) && game.snake.direction.x != 1 && allowMove)
+    }
+
+    cout << "Starting the game..." << endl;
+    int boardSize = cellSize * scenario.cellCount;
+    InitWindow(offset + sessionCount * (boardSize + offset), 2 * offset + boardSize, "Retro Snake");
+    SetTargetFPS(60);
+    InitAudioDevice();              // Initialize the audio system once for every game
+
+    {
+        Assets assets;
+        deque<Game> games;          // Deque keeps each game in place as more are added
+        for (int i = 0; i < sessionCount; i++)
         {
-            game.snake.direction = { -1, 0 };
-            game.running = true;
-            allowMove = false;
+            Vector2 origin = { (float)(offset + i * (boardSize + offset)), (float)offset };
+            games.emplace_back(assets, scenario.cellCount, origin);
+            if (hasScenario)
+            {
+                games.back().ApplyScenario(scenario);
+            }
         }
-        if (IsKeyPressed(KEY_RIGHT) && game.snake.direction.x != -1 && allowMove)
+
+        while (!WindowShouldClose())
         {
-            game.snake.direction = { 1, 0 };
-            game.running = true;
-            allowMove = false;
+            BeginDrawing();
+
+            // Handle user input for snake direction, draining every key pressed since the last frame.
+            // Every session receives the same key presses.
+            int key = GetKeyPressed();
+            while (key != 0)
+            {
+                Vector2 turn = { 0, 0 };
+                switch (key)
+                {
+                case KEY_UP:
+                    turn = { 0, -1 };
+                    break;
+                case KEY_DOWN:
+                    turn = { 0, 1 };
+                    break;
+                case KEY_LEFT:
+                    turn = { -1, 0 };
+                    break;
+                case KEY_RIGHT:
+                    turn = { 1, 0 };
+                    break;
+                }
+                if (turn.x != 0 || turn.y != 0)
+                {
+                    for (unsigned int i = 0; i < games.size(); i++)
+                    {
+                        games[i].QueueTurn(turn);
+                    }
+                }
+                key = GetKeyPressed();
+            }
+
+            for (unsigned int i = 0; i < games.size(); i++)
+            {
+                if (EventTriggered(games[i].gameSpeed, games[i].lastUpdateTime))
+                {
+                    games[i].Update();
+                    games[i].HandleEvents();
+                }
+            }
+
+            // Drawing
+            ClearBackground(green);
+            DrawText("Retro Snake", offset - 5, 20, 40, darkGreen);
+            for (unsigned int i = 0; i < games.size(); i++)
+            {
+                games[i].Draw();
+            }
+
+            EndDrawing();
         }
+    } // Games and assets are released before the audio device and window close
 
-        // Drawing
-        ClearBackground(green);
-        DrawRectangleLinesEx(Rectangle{ (float)offset - 5, (float)offset - 5, (float)cellSize * cellCount + 10, (float)cellSize * cellCount + 10 }, 5, darkGreen);
-        DrawText("Retro Snake", offset - 5, 20, 40, darkGreen);
-        game.Draw();
-
-        EndDrawing();
-    }
+    CloseAudioDevice();
     CloseWindow();
     return 0;
 }